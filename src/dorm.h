@@ -9,17 +9,21 @@
 #include <any>
 #include <typeinfo>
 #include <vector>
+#include <stdexcept>
 #include "field_type.h"
 #include "entity_map.h"
+#include "entity_cache.h"
 
 namespace dorm {
 
     struct Session;
+    template <typename T> struct CachedRepository;
 
     class Database
     {
     protected:
         std::map<std::type_index, std::unique_ptr<EntityMapBase>> entityMaps;
+        std::map<std::type_index, std::unique_ptr<EntityCacheBase>> entityCaches;
         virtual ~Database() = default;
         virtual void initialize() {};
     public:
@@ -45,6 +49,21 @@ namespace dorm {
             const EntityMapBase& m = *entityMaps.at(typeid(T));
             return static_cast<const EntityMap<T>&>(m);
         }
+
+        // Caches are shared by all sessions, configure them before any session is created.
+        template<typename T>
+        void configureCache(const CacheOptions& options = CacheOptions()) {
+            entityCaches.try_emplace(typeid(T), std::make_unique<EntityCache<T>>(options));
+        }
+
+        template<typename T>
+        EntityCache<T>* getEntityCache() const {
+            auto it = entityCaches.find(typeid(T));
+            if (it == entityCaches.end()) {
+                return nullptr;
+            }
+            return static_cast<EntityCache<T>*>(it->second.get());
+        }
     };
 
 
@@ -52,6 +71,7 @@ namespace dorm {
     {
     private:
         Database* _db;
+        template <typename> friend struct CachedRepository;
     public:
         Session(Database* db) : _db(db) {}
 
@@ -74,6 +94,9 @@ namespace dorm {
             _db->save(precord, typeid(T));
             std::cout<<std::any_cast<int>(precord->get("id"))<<std::endl;
             map.update(entity, precord);
+            if (auto* cache = _db->getEntityCache<T>()) {
+                cache->invalidate(entity.id());
+            }
         }
     };
 
@@ -81,16 +104,52 @@ namespace dorm {
     template <typename T>
     struct Repository
     {
-        Repository(const Session& session) : session(session) {}
+        Repository(Session& session) : session(session) {}
+        virtual ~Repository() = default;
 
-        std::unique_ptr<T> load(typename T::id_t id) {
-            return session.load<T>(id);
+        virtual std::unique_ptr<T> load(typename T::id_t id) {
+            return session.template load<T>(id);
         }
         virtual void save(T& entity) = 0;
         virtual void del(typename T::id_t id) = 0;
         // virtual QueryResult<T> query(const QueryClause&) = 0;
+    protected:
+        Session& session;
+    };
+
+
+    // Serves loads from the database wide EntityCache<T>, every load still returns a new entity.
+    template <typename T>
+    struct CachedRepository : public Repository<T>
+    {
+        CachedRepository(Session& session) : Repository<T>(session), _cache(session._db->getEntityCache<T>()) {
+            if (!_cache) {
+                throw std::runtime_error(std::string("Cache not configured for ") + typeid(T).name());
+            }
+        }
+
+        std::unique_ptr<T> load(typename T::id_t id) override {
+            Database* db = this->session._db;
+            auto snapshot = _cache->getOrLoad(id, [db, &id]() -> std::shared_ptr<RecordSnapshot> {
+                std::unique_ptr<DbRecord> record = db->load(id, typeid(T));
+                if (!record) {
+                    return nullptr;
+                }
+                return std::make_shared<RecordSnapshot>(*record, db->getEntityMap<T>(), db->SupportedFieldTypes);
+            });
+            if (!snapshot) {
+                return nullptr;
+            }
+            return db->getEntityMap<T>().create(snapshot.get());
+        }
+
+        void save(T& entity) override {
+            this->session.save(entity);
+        }
+
+        CacheStats stats() const { return _cache->stats(); }
     private:
-        const Session& session;
+        EntityCache<T>* _cache;
     };
 }
 
@@ -110,6 +169,8 @@ Obj obj = repo->load(1).as_copy();
 
 decision, only support unique_ptr, client side manage the lifecycle.
 Entity level cache can be implement at the repository level like CachedRepository.
+CachedRepository keeps immutable record snapshots in a database wide EntityCache, shared by sessions and threads,
+bounded by entry count and bytes with LRU eviction. Session::save drops the snapshot of the saved id.
 
 
 repo->save(Obj& obj)
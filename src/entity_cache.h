@@ -0,0 +1,221 @@
+#pragma once
+
+#include "entity_map.h"
+#include "field_type.h"
+#include <any>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <iterator>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace dorm {
+
+    // Immutable copy of a DbRecord, shared by every session that hits the cache.
+    class RecordSnapshot : public DbRecord
+    {
+        std::map<std::string, std::any> _values;
+        std::size_t _bytes;
+    public:
+        RecordSnapshot(DbRecord& record, const EntityMapBase& map,
+            const std::vector<std::unique_ptr<FieldTypeBase>>& fieldTypes) : _bytes(sizeof(RecordSnapshot)) {
+            for (auto& [columnName, fieldType, _, __] : map.columns()) {
+                auto value = record.get(columnName);
+                _bytes += sizeof(std::any) + columnName.size() + footprint(value, fieldTypes);
+                _values.emplace(columnName, std::move(value));
+            }
+        }
+
+        std::any get(const std::string& columnName) override {
+            return _values.at(columnName);
+        }
+
+        void set(const std::string& columnName, const std::any& value) override {
+            throw std::logic_error("RecordSnapshot is immutable, column " + columnName);
+        }
+
+        std::size_t bytes() const { return _bytes; }
+
+    private:
+        static std::size_t footprint(const std::any& value,
+            const std::vector<std::unique_ptr<FieldTypeBase>>& fieldTypes) {
+            for (auto& ft : fieldTypes) {
+                if (ft->type() == value.type()) {
+                    return ft->footprint(value);
+                }
+            }
+            return 0;
+        }
+    };
+
+    struct CacheOptions {
+        std::size_t maxEntries = 1024;
+        std::size_t maxBytes = 1024 * 1024;
+    };
+
+    struct CacheStats {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        std::size_t evictions = 0;
+        std::size_t entries = 0;
+        std::size_t bytes = 0;
+        double hitRatio() const {
+            auto total = hits + misses;
+            return total == 0 ? 0.0 : static_cast<double>(hits) / total;
+        }
+    };
+
+    struct EntityCacheBase {
+        virtual CacheStats stats() const = 0;
+        virtual void clear() = 0;
+        virtual ~EntityCacheBase() = default;
+    };
+
+    // Size-bounded LRU cache of record snapshots for one entity type, shared across sessions and threads.
+    // Concurrent misses on the same id are coalesced into a single backend load.
+    template<typename T>
+    class EntityCache : public EntityCacheBase {
+    public:
+        using id_t = typename T::id_t;
+        using snapshot_ptr = std::shared_ptr<RecordSnapshot>;
+
+        EntityCache(const CacheOptions& options) : _options(options) {}
+
+        template<typename TLoader>
+        snapshot_ptr getOrLoad(const id_t& id, TLoader&& loader) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            auto it = _index.find(id);
+            if (it != _index.end()) {
+                ++_stats.hits;
+                _lru.splice(_lru.begin(), _lru, it->second);
+                return it->second->snapshot;
+            }
+            ++_stats.misses;
+
+            auto loading = _loading.find(id);
+            if (loading != _loading.end()) {
+                auto result = loading->second->result;
+                lock.unlock();
+                return result.get();
+            }
+
+            auto flight = std::make_shared<InFlight>();
+            flight->result = flight->promise.get_future().share();
+            _loading.emplace(id, flight);
+            lock.unlock();
+
+            snapshot_ptr snapshot;
+            try {
+                snapshot = loader();
+            } catch (...) {
+                lock.lock();
+                finish(id, flight);
+                lock.unlock();
+                flight->promise.set_exception(std::current_exception());
+                throw;
+            }
+
+            lock.lock();
+            if (snapshot && !flight->stale) {
+                insert(id, snapshot);
+            }
+            finish(id, flight);
+            lock.unlock();
+            flight->promise.set_value(snapshot);
+            return snapshot;
+        }
+
+        // Drops the cached snapshot, and keeps any load already in flight from publishing its stale result.
+        void invalidate(const id_t& id) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto loading = _loading.find(id);
+            if (loading != _loading.end()) {
+                loading->second->stale = true;
+                _loading.erase(loading);
+            }
+            auto it = _index.find(id);
+            if (it != _index.end()) {
+                erase(it->second);
+                _index.erase(it);
+            }
+        }
+
+        CacheStats stats() const override {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto result = _stats;
+            result.entries = _index.size();
+            result.bytes = _bytes;
+            return result;
+        }
+
+        void clear() override {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (auto& [_, flight] : _loading) {
+                flight->stale = true;
+            }
+            _loading.clear();
+            _index.clear();
+            _lru.clear();
+            _bytes = 0;
+        }
+
+    private:
+        struct Entry {
+            id_t id;
+            snapshot_ptr snapshot;
+        };
+
+        struct InFlight {
+            std::promise<snapshot_ptr> promise;
+            std::shared_future<snapshot_ptr> result;
+            bool stale = false;
+        };
+
+        CacheOptions _options;
+        mutable std::mutex _mutex;
+        std::list<Entry> _lru; // most recently used first
+        std::unordered_map<id_t, typename std::list<Entry>::iterator> _index;
+        std::unordered_map<id_t, std::shared_ptr<InFlight>> _loading;
+        std::size_t _bytes = 0;
+        CacheStats _stats;
+
+        void insert(const id_t& id, const snapshot_ptr& snapshot) {
+            if (snapshot->bytes() > _options.maxBytes || _options.maxEntries == 0) {
+                return;
+            }
+            auto existing = _index.find(id);
+            if (existing != _index.end()) {
+                erase(existing->second);
+            }
+            _lru.push_front({id, snapshot});
+            _index[id] = _lru.begin();
+            _bytes += snapshot->bytes();
+            while (_index.size() > _options.maxEntries || _bytes > _options.maxBytes) {
+                auto last = std::prev(_lru.end());
+                _index.erase(last->id);
+                erase(last);
+                ++_stats.evictions;
+            }
+        }
+
+        void erase(typename std::list<Entry>::iterator it) {
+            _bytes -= it->snapshot->bytes();
+            _lru.erase(it);
+        }
+
+        void finish(const id_t& id, const std::shared_ptr<InFlight>& flight) {
+            auto it = _loading.find(id);
+            if (it != _loading.end() && it->second == flight) {
+                _loading.erase(it);
+            }
+        }
+    };
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <any>
+#include <cstddef>
+#include <string>
 #include <typeindex>
 
 namespace dorm {
@@ -9,6 +11,7 @@ namespace dorm {
         FieldTypeBase(const std::type_index& type) : _type(type) {}
         std::type_index type() const { return _type; }
         virtual bool equal(const std::any& lhs, const std::any& rhs) const = 0;
+        virtual std::size_t footprint(const std::any& value) const = 0;
         virtual ~FieldTypeBase() = default;
     private:
         std::type_index _type;
@@ -23,5 +26,12 @@ namespace dorm {
                 (lhs.type() == typeid(T) && rhs.type() == typeid(T) 
                     && std::any_cast<const T&>(lhs) == std::any_cast<const T&>(rhs));
         }
+        std::size_t footprint(const std::any& value) const override {
+            return value.type() == typeid(T) ? sizeof(T) + heap(std::any_cast<const T&>(value)) : 0;
+        }
+    private:
+        template<typename TV>
+        static std::size_t heap(const TV&) { return 0; }
+        static std::size_t heap(const std::string& s) { return s.capacity(); }
     };   
 }
\ No newline at end of file
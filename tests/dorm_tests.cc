@@ -1,4 +1,8 @@
+#include <atomic>
+#include <chrono>
 #include <string>
+#include <thread>
+#include <vector>
 #include <gtest/gtest.h>
 #include "dorm.h"
 #include "entity.h"
@@ -34,6 +38,26 @@ public:
     }
 };
 
+class PersonRepository : public CachedRepository<Person>
+{
+public:
+    PersonRepository(Session& session) : CachedRepository<Person>(session) {}
+    void del(int id) override {}
+};
+
+class CountingDatabase : public in_mem::InMemDatabase
+{
+public:
+    std::atomic<int> loads{0};
+    std::chrono::milliseconds delay{0};
+
+    std::unique_ptr<DbRecord> load(const std::any& id, const std::type_info& type) override {
+        ++loads;
+        std::this_thread::sleep_for(delay);
+        return in_mem::InMemDatabase::load(id, type);
+    }
+};
+
 TEST(DormTest, should_return_null_if_nothing_in_database)
 {
     in_mem::InMemDatabase db;
@@ -95,3 +119,113 @@ TEST(DormTest, should_return_generated_id)
 //     ASSERT_EQ(p11->age(), 30);
 //     ASSERT_EQ(p11->name(), "John Doe");
 // }
+
+TEST(CachedRepositoryTest, should_serve_other_sessions_from_cache)
+{
+    CountingDatabase db;
+    db.configure<PersonMap>();
+    db.configureCache<Person>();
+    db.initialize();
+
+    auto p = Person("John Doe", 30);
+    db.createSession()->save(p);
+
+    auto session1 = db.createSession();
+    auto p1 = PersonRepository(*session1).load(p.id());
+    auto session2 = db.createSession();
+    auto p2 = PersonRepository(*session2).load(p.id());
+
+    ASSERT_NE(p1, nullptr);
+    ASSERT_NE(p2, nullptr);
+    ASSERT_NE(p1.get(), p2.get());
+    ASSERT_EQ(p2->name(), "John Doe");
+    ASSERT_EQ(db.loads, 1);
+    auto stats = db.getEntityCache<Person>()->stats();
+    ASSERT_EQ(stats.hits, 1);
+    ASSERT_EQ(stats.misses, 1);
+    ASSERT_EQ(stats.entries, 1);
+    ASSERT_GT(stats.bytes, 0);
+    ASSERT_DOUBLE_EQ(stats.hitRatio(), 0.5);
+}
+
+TEST(CachedRepositoryTest, should_invalidate_on_save)
+{
+    CountingDatabase db;
+    db.configure<PersonMap>();
+    db.configureCache<Person>();
+    db.initialize();
+
+    auto session = db.createSession();
+    PersonRepository repo(*session);
+    auto p = Person("John Doe", 30);
+    session->save(p);
+    repo.load(p.id());
+
+    p.name("John Smith");
+    db.createSession()->save(p);
+    auto p1 = repo.load(p.id());
+
+    ASSERT_EQ(p1->name(), "John Smith");
+    ASSERT_EQ(db.loads, 2);
+}
+
+TEST(CachedRepositoryTest, should_evict_least_recently_used)
+{
+    CountingDatabase db;
+    db.configure<PersonMap>();
+    CacheOptions options;
+    options.maxEntries = 2;
+    db.configureCache<Person>(options);
+    db.initialize();
+
+    auto session = db.createSession();
+    PersonRepository repo(*session);
+    auto p1 = Person("John Doe", 30);
+    auto p2 = Person("John Smith", 35);
+    auto p3 = Person("Jane Doe", 28);
+    session->save(p1);
+    session->save(p2);
+    session->save(p3);
+
+    repo.load(p1.id());
+    repo.load(p2.id());
+    repo.load(p1.id());
+    repo.load(p3.id());
+    ASSERT_EQ(db.loads, 3);
+
+    repo.load(p1.id());
+    ASSERT_EQ(db.loads, 3);
+    repo.load(p2.id());
+    ASSERT_EQ(db.loads, 4);
+    ASSERT_EQ(db.getEntityCache<Person>()->stats().entries, 2);
+    ASSERT_EQ(db.getEntityCache<Person>()->stats().evictions, 2);
+}
+
+TEST(CachedRepositoryTest, should_load_once_on_concurrent_misses)
+{
+    CountingDatabase db;
+    db.configure<PersonMap>();
+    db.configureCache<Person>();
+    db.initialize();
+
+    auto p = Person("John Doe", 30);
+    db.createSession()->save(p);
+    db.delay = std::chrono::milliseconds(50);
+
+    std::vector<std::thread> threads;
+    std::atomic<int> found{0};
+    for (auto i = 0; i < 8; i++) {
+        threads.emplace_back([&]() {
+            auto session = db.createSession();
+            if (PersonRepository(*session).load(p.id())) {
+                ++found;
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    ASSERT_EQ(found, 8);
+    ASSERT_EQ(db.loads, 1);
+}